@@ -0,0 +1,50 @@
+#ifndef ANNEAL_H
+#define ANNEAL_H
+
+#include <cmath>
+#include "size.h"
+
+// cooling schedules of the simulated annealing sampler
+#define ANNEAL_NONE 0    // fixed temperature replicas
+#define ANNEAL_LINEAR 1  // linear in temperature
+#define ANNEAL_EXP 2     // geometric in temperature
+#define ANNEAL_RESTART 3 // geometric, restarted anneal_cycles times
+
+#ifdef __CUDACC__
+#define ANNEAL_FUNC __host__ __device__ __forceinline__
+#else
+#define ANNEAL_FUNC inline
+#endif
+
+// minus_beta at a given step, cooling from temp_start down to the replica
+// temperature (given by its minus_beta_end) over steps_total steps,
+// the replica temperature is kept once steps_total is reached
+ANNEAL_FUNC float AnnealMinusBeta(const int mode, const float temp_start,
+                                  const int cycles, const float minus_beta_end,
+                                  const int step, const int steps_total) {
+  if (mode == ANNEAL_NONE || step >= steps_total)
+    return minus_beta_end;
+
+  const float temp_end = -1.0f / (BOLTZMANN_CONST * minus_beta_end);
+  float frac = (float) step / (float) steps_total;
+  float temp;
+
+  switch (mode) {
+  case ANNEAL_LINEAR:
+    temp = temp_start + (temp_end - temp_start) * frac;
+    break;
+  case ANNEAL_RESTART:
+    frac = frac * cycles - floorf(frac * cycles);
+    temp = temp_start * powf(temp_end / temp_start, frac);
+    break;
+  case ANNEAL_EXP:
+    temp = temp_start * powf(temp_end / temp_start, frac);
+    break;
+  default:
+    return minus_beta_end;
+  }
+
+  return -1.0f / (BOLTZMANN_CONST * temp);
+}
+
+#endif // ANNEAL_H
@@ -0,0 +1,33 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <string>
+
+#include "dock.h"
+#include "hdf5io.h"
+#include "traj_io.h"
+
+using namespace std;
+
+// async_writer.C
+// output thread of the sampling loop, the launcher hands over the drained
+// records and the progress lines through a bounded queue, and the writer
+// serializes them to the HDF5 (hdf5io.C) and binary (traj_io.C) trajectories
+
+struct AsyncWriter;
+
+// the writer owns the sinks from now on, either may be NULL
+// at most depth jobs are queued, a full queue blocks the producer
+AsyncWriter *StartAsyncWriter(const int depth, H5Traj *h5traj, TrajWriter *traj);
+
+// queue a copy of n records
+void SubmitRecords(AsyncWriter *writer, const LigRecordSingleStep *steps, const int n);
+
+// queue a line for stdout
+void SubmitLog(AsyncWriter *writer, const string &line);
+
+// write what is queued, close the sinks and join the thread
+// returns the seconds the producer spent blocked on a full queue
+double StopAsyncWriter(AsyncWriter *writer);
+
+#endif // ASYNC_WRITER_H
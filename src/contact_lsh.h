@@ -0,0 +1,43 @@
+#ifndef CONTACT_LSH_H
+#define CONTACT_LSH_H
+
+#include <vector>
+
+#include "util.h"
+
+using namespace std;
+
+// contact_lsh.C
+// MinHash signatures of the contact sets of ContactMaps, and a bucketing of
+// the near-duplicate poses by banded locality-sensitive hashing
+//
+// two poses share a band with probability 1 - (1 - J^LSH_ROWS)^LSH_BANDS for
+// the Jaccard index J of their contact sets, 0.98 at J = 0.8 and 0.06 at
+// J = 0.3, the candidates are then checked on the exact bitsets
+
+#define LSH_BANDS 8
+#define LSH_ROWS 4
+#define LSH_HASHES (LSH_BANDS * LSH_ROWS)
+
+// a pose joins the bucket of a leader when their Jaccard index is at least
+#define LSH_MIN_JACCARD 0.8f
+
+// leaders checked per band, bounds the work on crowded bands
+#define LSH_MAX_CANDIDATES 4
+
+// Jaccard index of the contact sets of poses a and b, 1 for two empty sets
+float ContactMapJaccard(const ContactMaps &maps, const int a, const int b);
+
+// LSH_HASHES minimum hashes of the set bits of each pose, pose i at
+// sig[i * LSH_HASHES]
+void MinHashSignatures(const ContactMaps &maps, vector<unsigned int> *sig);
+
+// leader[i] gets the pose leading the bucket of pose i, a leader leads
+// itself, the poses are taken in order and each joins the first leader met
+// on its bands with a Jaccard index of at least min_jaccard, or leads a new
+// bucket
+// returns the number of buckets
+int BucketNearDuplicates(const ContactMaps &maps, const float min_jaccard,
+                         vector<int> *leader);
+
+#endif // CONTACT_LSH_H
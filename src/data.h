@@ -28,12 +28,21 @@ std::string one2three (std::string);
 
 int getResCode (std::string);
 
+// residue code of the three letters at r_name, -1 if unknown
+// a table lookup, for the PDB parser
+int lookupResCode (const char *r_name);
+
 int getResCodeOne (std::string);
 
 std::string getResName (int);
 
 int getPntCode (std::string);
 
+// codes of the len characters at name, -1 if unknown
+// hashed lookups, for the loaders of load.C
+int lookupPntCode (const char *name, const int len);
+int lookupLigCode (const char *name, const int len);
+
 std::string getPntName (int);
 
 int getLigCode (std::string);
@@ -0,0 +1,44 @@
+#ifndef DIST_MAT_H
+#define DIST_MAT_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// condensed symmetric distance matrix of n objects
+// the upper triangle with the diagonal is stored row by row in floats, a
+// quarter of the memory of a full matrix of doubles, with O(1) indexing
+
+class DistMat
+{
+public:
+  explicit DistMat(const int n) : n(n), d((size_t) n * (n + 1) / 2, 0.0f) {}
+
+  int size() const { return n; }
+
+  float at(int i, int j) const {
+    if (i > j)
+      std::swap(i, j);
+    return d[row(i) + (j - i)];
+  }
+
+  void set(int i, int j, const float v) {
+    if (i > j)
+      std::swap(i, j);
+    d[row(i) + (j - i)] = v;
+  }
+
+  // the entries (i, i), (i, i + 1), ..., (i, n - 1)
+  float *upper(const int i) { return &d[row(i)]; }
+  const float *upper(const int i) const { return &d[row(i)]; }
+
+private:
+  size_t row(const int i) const {
+    return (size_t) i * (2 * (size_t) n - i + 1) / 2;
+  }
+
+  int n;
+  std::vector<float> d;
+};
+
+#endif // DIST_MAT_H
@@ -340,18 +340,39 @@ struct McPara
 
   float move_scale[6]; // translation x y z, rotation x y z
 
+  int min_iter;  // simplex iterations of the local refinement, 0 disables it
+  int min_every; // also refine every k-th accepted state, 0 only medoids
+
+  int anneal_mode;   // cooling schedule, ANNEAL_NONE for fixed temperatures
+  float anneal_temp; // starting temperature of the cooling schedule
+  int anneal_cycles; // number of cooling cycles of ANNEAL_RESTART
+
+  float conf_switch_prob; // chance of a conformer switch instead of a rigid move
+  int is_conf_exchange;   // swap conformers between neighboring replicas, at the dump boundaries
+
+  int prune_every;  // steps between two pruning rounds, 0 disables pruning
+  float prune_frac; // fraction of the highest energy replicas retired per round
+
+  int record_cap; // slots of the device trajectory ring, 0 for the expected states of two dumps
+  int online_k;   // clusters of the online clustering, 0 keeps every state for post_mc
+
   char hdf_path[MAXSTRINGLENG];
   char csv_path[MAXSTRINGLENG];
+  char traj_path[MAXSTRINGLENG]; // compressed trajectory, see traj_io.h
+  int traj_energy;               // energy encoding of the compressed trajectory
 };
 
 struct McLog
 {
-  double t0, t1, t2; // time escape
+  double t0, t1, t2; // time escape, t2 is the time the sampling loop waited on output
   int ac_temp_exchg;
   int acs_temp_exchg[MAXREP]; 
   int ac_mc;
   float ar;
   int steps_total;
+  int n_pruned; // replicas respawned by the population control
+  int n_dropped; // accepted states lost because the trajectory ring was full
+  int n_waits;   // times the launcher waited for the record consumer
   
   // int ac_lig_exchg;
   // int acs_lig_exchg[MAXREP];
@@ -380,6 +401,16 @@ struct LigRecord
   int next_ptr; // next available record stop
 };
 
+// device trajectory ring, the blocks reserve slots by bumping head, position
+// pos lives in slot pos % capacity, and [tail, head) is not drained yet
+struct RecordRing
+{
+  unsigned long long head;
+  unsigned long long tail;
+  unsigned long long capacity;
+  unsigned int n_dropped; // reservations that found the ring full
+};
+
 struct LigMoveVector
 {
   float ele[6]; // translation xyz, rotation xyz
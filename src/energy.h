@@ -0,0 +1,26 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include "size.h"
+#include "dock.h"
+
+// energy.C
+// host side mirror of CalcEnergy_d / CalcRmsd_d / CalcMcc_d, used to score
+// poses outside of the Monte Carlo kernels (refinement, re-scoring)
+
+// evaluate all energy terms of mylig->coord_new against myprt
+// fills mylig->energy_new.e[], normalized and combined like the GPU kernel
+void CalcEnergy(Ligand *mylig, const Protein *const myprt,
+                const Psp *const psp, const Kde *const kde,
+                const Mcs *const mcs, const EnePara *const enepara,
+                const int pos);
+
+// rmsd between mylig->coord_new and the conformer at its initial placement
+void CalcRmsd(Ligand *mylig);
+
+// contact mode score of mylig->coord_new against a reference contact matrix
+// ref_matrix is lna x pnp, as filled by InitContactMatrix
+void CalcMcc(Ligand *mylig, const Protein *const myprt,
+             const EnePara *const enepara, int *ref_matrix, int *buf_matrix);
+
+#endif // ENERGY_H
@@ -2,6 +2,13 @@
 #define  HDF5IO_H
 
 
+#include <vector>
+
+#include "dock.h"
+
+using namespace std;
+
+
 #define DATASET "dset"
 
 void
@@ -12,4 +19,38 @@ ReadLigRecord (LigRecord * ligrecord, const int recsize, const char *h5file);
 
 
 
+// one file per run, the accepted states go to an extendible dataset "steps"
+// (chunked, shuffle + deflate), each append is grouped by replica and the
+// runs of a replica are listed in the extendible dataset "rep_index"
+
+#define H5TRAJ_STEPS "steps"
+#define H5TRAJ_INDEX "rep_index"
+#define H5TRAJ_STEPS_CHUNK 4096
+#define H5TRAJ_INDEX_CHUNK 1024
+#define H5TRAJ_DEFLATE 4
+
+struct H5TrajRun
+{
+  int idx_rep;
+  long long offset; // first row in "steps"
+  int count;
+};
+
+struct H5Traj;
+
+H5Traj *
+OpenH5Traj (const char *h5file);
+
+void
+AppendH5Traj (H5Traj * traj, const LigRecordSingleStep * steps, const int n);
+
+void
+CloseH5Traj (H5Traj * traj);
+
+// append the rows of one replica to steps, returns the number of rows
+int
+ReadH5TrajReplica (const char *h5file, const int idx_rep, vector < LigRecordSingleStep > &steps);
+
+
+
 #endif
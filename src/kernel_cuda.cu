@@ -13,9 +13,13 @@ __constant__ Ligand *lig_dc;
 __constant__ Replica *replica_dc;
 __constant__ float *etotal_dc;
 __constant__ LigMoveVector *ligmovevector_dc;
-__constant__ LigRecord *ligrecord_dc;
+__constant__ LigRecordSingleStep *ligring_dc;
+__constant__ RecordRing *recordring_dc;
 __constant__ int *acs_temp_exchg_dc;
 __constant__ ConfusionMatrix *ref_matrix_dc;
+__constant__ LigCoord *ligconf_dc;
+__constant__ Energy *swap_energy_dc;
+__constant__ int *prune_dc;
 
 
 // PRNG seeds
@@ -30,6 +34,14 @@ __constant__ int steps_per_dump_dc;
 __constant__ int steps_total_dc;
 __constant__ float * move_scale_dc;
 
+// ligand conformer moves
+__constant__ float conf_switch_prob_dc;
+
+// simulated annealing schedule
+__constant__ int anneal_mode_dc;
+__constant__ float anneal_temp_dc;
+__constant__ int anneal_cycles_dc;
+
 __constant__ float enepara_lj0_dc;
 __constant__ float enepara_lj1_dc;
 __constant__ float enepara_el0_dc;
@@ -53,8 +65,9 @@ __constant__ int pnk_dc;
 __constant__ int pos_dc;
 
 
-#include "kernel_cuda_l1_resetcounter.cu"
 #include "kernel_cuda_l1_exchangereplicas.cu"
+#include "kernel_cuda_l1_calcswapenergy.cu"
+#include "kernel_cuda_l1_clonereplicas.cu"
 #include "kernel_cuda_l1_initcurand.cu"
 #include "kernel_cuda_l1_montecarlo.cu"
 #include "kernel_cuda_l2_accept.cu"
@@ -62,6 +75,7 @@ __constant__ int pos_dc;
 #include "kernel_cuda_l2_calcmcc.cu"
 #include "kernel_cuda_l2_calcrmsd.cu"
 #include "kernel_cuda_l2_move.cu"
+#include "kernel_cuda_l2_switchconf.cu"
 #include "kernel_cuda_l3_combineenergy.cu"
 #include "kernel_cuda_l3_util.cu"
 
@@ -4,14 +4,22 @@
 
 __global__ void InitCurand_d ();
 
-__global__ void ResetCounter_d (const int, const int);
-
 __global__ void ExchangeReplicas_d (const int, const int);
 
 __global__ void MonteCarlo_Init_d (const int, const int);
 
 __global__ void MonteCarlo_d (const int, const int, const int, const int);
 
+__global__ void MonteCarloPersistent_d (const int, const int, const int, const int);
+
+__device__ void MonteCarloSteps_d (const int, const int, const int, const int, const int);
+
+__device__ void ExchangeTemperatures_d (const int, const int, const int);
+
+__global__ void CalcSwapEnergy_d (const int, const int, const int);
+
+__global__ void CloneReplicas_d (const int);
+
 
 
 
@@ -20,6 +28,10 @@ __device__ void CalcRmsd_d (const int, Ligand * __restrict__);
 
 __device__ void Move_d (const int, Ligand * __restrict__, const float);
 
+__device__ void SwitchConf_d (const int, Ligand * __restrict__, const int);
+
+__device__ int ConfPartner_d (const int, const int);
+
 __device__ void CalcEnergy_d (const int, Ligand * __restrict__, const Protein * __restrict__);
 
 __device__ void CombineEnergy_d (const int, Energy *);
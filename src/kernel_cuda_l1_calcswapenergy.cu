@@ -0,0 +1,51 @@
+/*
+#include <cstdio>
+
+#include "dock.h"
+#include "gpu.cuh"
+*/
+
+
+
+// energy of each replica's pose when wearing the conformer of its exchange
+// partner, consumed by the ligand exchange of ExchangeReplicas_d
+
+__global__ void
+CalcSwapEnergy_d (const int rep_begin, const int rep_end, const int mode_l)
+{
+  const int bidx = blockDim.x * threadIdx.y + threadIdx.x;      // within a TB
+
+  for (int offset = rep_begin; offset <= rep_end; offset += GD) {
+    const int myreplica = offset + blockIdx.x;
+
+    if (myreplica <= rep_end) {
+      const int partner = ConfPartner_d (myreplica, mode_l);
+
+      if (partner >= 0) {
+	Ligand *mylig = &lig_dc[replica_dc[myreplica].idx_rep];
+	const Protein *myprt = &prt_dc[replica_dc[myreplica].idx_prt];
+
+	SwitchConf_d (bidx, mylig, replica_dc[partner].idx_lig);
+	Move_d (bidx, mylig, 0.0f);
+
+#if IS_CALCU_RMSD == 1
+	CalcRmsd_d (bidx, mylig);
+#endif
+
+#if IS_CALCU_MCC == 1
+	CalcMcc_d (bidx, mylig, myprt);
+#endif
+
+	CalcEnergy_d (bidx, mylig, myprt);
+	__syncthreads ();
+
+	if (bidx == 0)
+	  swap_energy_dc[myreplica] = mylig->energy_new;
+
+	// restore its own conformer
+	SwitchConf_d (bidx, mylig, replica_dc[myreplica].idx_lig);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,64 @@
+/*
+#include <cstdio>
+
+#include "dock.h"
+#include "gpu.cuh"
+*/
+
+
+
+// population control, respawn the retired replicas prune_dc[2k] as
+// perturbed clones of the promising replicas prune_dc[2k + 1]
+// the clone keeps its own protein and temperature, and takes over the
+// conformer and pose of its source
+
+__global__ void
+CloneReplicas_d (const int n_pairs)
+{
+  const int bidx = blockDim.x * threadIdx.y + threadIdx.x;      // within a TB
+
+  for (int pair = blockIdx.x; pair < n_pairs; pair += GD) {
+    const int dst = prune_dc[2 * pair];
+    const int src = prune_dc[2 * pair + 1];
+
+    Ligand *mylig = &lig_dc[replica_dc[dst].idx_rep];
+    const Ligand *srclig = &lig_dc[replica_dc[src].idx_rep];
+    const Protein *myprt = &prt_dc[replica_dc[dst].idx_prt];
+
+    for (int l = bidx; l < lna_dc; l += TperB) {
+      mylig->coord_orig.x[l] = srclig->coord_orig.x[l];
+      mylig->coord_orig.y[l] = srclig->coord_orig.y[l];
+      mylig->coord_orig.z[l] = srclig->coord_orig.z[l];
+    }
+    if (bidx < 6)
+      mylig->movematrix_old[bidx] = srclig->movematrix_old[bidx];
+    if (bidx == 0)
+      replica_dc[dst].idx_lig = replica_dc[src].idx_lig;
+    __syncthreads ();
+
+    Move_d (bidx, mylig, 2.0f * MyRand_d () - 1.0f);
+
+#if IS_CALCU_RMSD == 1
+    CalcRmsd_d (bidx, mylig);
+#endif
+
+#if IS_CALCU_MCC == 1
+    CalcMcc_d (bidx, mylig, myprt);
+#endif
+
+    CalcEnergy_d (bidx, mylig, myprt);
+
+    __syncthreads ();
+
+    // the perturbed clone is the new state, it gets recorded with the next
+    // accepted move so that the per dump record capacity still holds
+    if (bidx < 6)
+      mylig->movematrix_old[bidx] = mylig->movematrix_new[bidx];
+    if (bidx == 0) {
+      mylig->energy_old = mylig->energy_new;
+      etotal_dc[dst] = mylig->energy_old.e[MAXWEI - 1];
+    }
+    __syncthreads ();
+  }
+
+}
@@ -3,6 +3,65 @@
 // mode 1: 0 , 1 swap 2 , 3 swap 4 , ...
 // mode 3: random
 // mode 4: not exchange
+// the ligand modes pair neighbors in the ligand dimension, see ConfPartner_d
+
+// temperature exchange among the replicas sharing protein p and ligand l
+// executed by a single thread
+
+__device__ void
+ExchangeTemperatures_d (const int p, const int l, const int mode_t)
+{
+  int temps[MAXTMP];
+  int temp_orders[MAXTMP];
+  float energies[MAXTMP];
+
+  // copy index from the replica structure
+  for (int t = 0; t < n_tmp_dc; ++t) {
+    const int flatten_addr =
+      n_tmp_dc * n_lig_dc * p + n_lig_dc * t + l;
+    temps[t] = replica_dc[flatten_addr].idx_tmp;
+    energies[t] = etotal_dc[flatten_addr];
+    temp_orders[temps[t]] = t;
+  }
+
+
+  // exchange temperature
+  const int maxpair = n_tmp_dc / 2 - (n_tmp_dc % 2 == 0) * (mode_t == 1);
+  for (int pair = 0 ; pair < maxpair; ++pair) {
+    const int i1 = (pair << 1) + mode_t;
+    const int i2 = i1 + 1;
+    const int o1 = temp_orders[i1];
+    const int o2 = temp_orders[i2];
+    const int tt = temps[o1];
+
+    float etot1 = energies[o1];
+    float etot2 = energies[o2];
+    float minus_beta1 = temp_dc[temps[o1]].minus_beta;
+    float minus_beta2 = temp_dc[temps[o2]].minus_beta;
+
+    float delta = (minus_beta1 - minus_beta2) * (etot2 - etot1);
+    float exchange_prob = expf(delta);
+    // printf("exchange_prob: %f\n", exchange_prob);
+    // printf("etot1: %f, minus_beta1: %f\n", etot1, minus_beta1);
+    // printf("etot2: %f, minus_beta2: %f\n", etot2, minus_beta2);
+    if (exchange_prob > MyRand_d()) {
+      temps[o1] = temps[o2];
+      temps[o2] = tt;
+      acs_temp_exchg_dc[o1] += 1;
+      acs_temp_exchg_dc[o2] += 1;
+    }
+  }
+
+
+  // copy index to the replica structure
+  for (int t = 0; t < n_tmp_dc; ++t) {
+    const int flatten_addr =
+      n_tmp_dc * n_lig_dc * p + n_lig_dc * t + l;
+    replica_dc[flatten_addr].idx_tmp = temps[t];
+  }
+}
+
+
 
 __global__ void
 ExchangeReplicas_d (const int mode_l, const int mode_t)
@@ -19,64 +78,53 @@ ExchangeReplicas_d (const int mode_l, const int mode_t)
     //__shared__ int idx_lig[MAXREP];
     
 
-    __shared__ int temps[MAXTMP];
-    __shared__ int temp_orders[MAXTMP];
-    __shared__ float energies[MAXTMP];
-
-
     if (bidx == 0) {
 
-      for (int p = 0; p < n_prt_dc; ++p) {
-	for (int l = 0; l < n_lig_dc; ++l) {
-
-	  // copy index from the replica structure
-	  for (int t = 0; t < n_tmp_dc; ++t) {
-	     const int flatten_addr =
-	       n_tmp_dc * n_lig_dc * p + n_lig_dc * t + l;
-	     temps[t] = replica_dc[flatten_addr].idx_tmp;
-	     energies[t] = etotal_dc[flatten_addr];
-	     temp_orders[temps[t]] = t;
-	  }
+      if (mode_t < 2) {
+	for (int p = 0; p < n_prt_dc; ++p)
+	  for (int l = 0; l < n_lig_dc; ++l)
+	    ExchangeTemperatures_d (p, l, mode_t);
+      }
 
 
-	  // exchange temperature
-	  if (mode_t < 2) {
-	    const int maxpair = n_tmp_dc / 2 - (n_tmp_dc % 2 == 0) * (mode_t == 1);
-	    for (int pair = 0 ; pair < maxpair; ++pair) {
-	      const int i1 = (pair << 1) + mode_t;
-	      const int i2 = i1 + 1;
-	      const int o1 = temp_orders[i1];
-	      const int o2 = temp_orders[i2];
-	      const int tt = temps[o1];
-	      
-	      float etot1 = energies[o1];
-	      float etot2 = energies[o2];
-	      float minus_beta1 = temp_dc[temps[o1]].minus_beta;
-	      float minus_beta2 = temp_dc[temps[o2]].minus_beta;
-	      
-	      float delta = (minus_beta1 - minus_beta2) * (etot2 - etot1);
-	      float exchange_prob = expf(delta);
-	      // printf("exchange_prob: %f\n", exchange_prob);
-	      // printf("etot1: %f, minus_beta1: %f\n", etot1, minus_beta1);
-	      // printf("etot2: %f, minus_beta2: %f\n", etot2, minus_beta2);
-	      if (exchange_prob > MyRand_d()) {
-		temps[o1] = temps[o2];
-		temps[o2] = tt;
-		acs_temp_exchg_dc[o1] += 1;
-		acs_temp_exchg_dc[o2] += 1;
+      // exchange ligand conformers, the pose of each replica is kept
+      // energies of the swapped states come from CalcSwapEnergy_d
+      if (mode_l < 2) {
+	for (int r1 = 0; r1 < n_rep_dc; ++r1) {
+	  const int r2 = ConfPartner_d (r1, mode_l);
+	  if (r2 > r1) {
+	    Ligand *lig1 = &lig_dc[replica_dc[r1].idx_rep];
+	    Ligand *lig2 = &lig_dc[replica_dc[r2].idx_rep];
+	    const float minus_beta1 = temp_dc[replica_dc[r1].idx_tmp].minus_beta;
+	    const float minus_beta2 = temp_dc[replica_dc[r2].idx_tmp].minus_beta;
+
+	    const float delta =
+	      minus_beta1 * (swap_energy_dc[r1].e[MAXWEI - 1] - lig1->energy_old.e[MAXWEI - 1]) +
+	      minus_beta2 * (swap_energy_dc[r2].e[MAXWEI - 1] - lig2->energy_old.e[MAXWEI - 1]);
+
+	    if (expf (delta) > MyRand_d ()) {
+	      const int ll = replica_dc[r1].idx_lig;
+	      replica_dc[r1].idx_lig = replica_dc[r2].idx_lig;
+	      replica_dc[r2].idx_lig = ll;
+
+	      const LigCoord *conf1 = &ligconf_dc[replica_dc[r1].idx_lig];
+	      const LigCoord *conf2 = &ligconf_dc[replica_dc[r2].idx_lig];
+	      for (int l = 0; l < lna_dc; ++l) {
+		lig1->coord_orig.x[l] = conf1->x[l];
+		lig1->coord_orig.y[l] = conf1->y[l];
+		lig1->coord_orig.z[l] = conf1->z[l];
+		lig2->coord_orig.x[l] = conf2->x[l];
+		lig2->coord_orig.y[l] = conf2->y[l];
+		lig2->coord_orig.z[l] = conf2->z[l];
 	      }
-	    }
-	  }
 
- 
-	  // copy index to the replica structure
-	  for (int t = 0; t < n_tmp_dc; ++t) {
-	    const int flatten_addr =
-	      n_tmp_dc * n_lig_dc * p + n_lig_dc * t + l;
-	    replica_dc[flatten_addr].idx_tmp = temps[t];
+	      lig1->energy_old = swap_energy_dc[r1];
+	      lig2->energy_old = swap_energy_dc[r2];
+	      etotal_dc[r1] = lig1->energy_old.e[MAXWEI - 1];
+	      etotal_dc[r2] = lig2->energy_old.e[MAXWEI - 1];
+	    }
 	  }
-
-        }
+	}
       }
 
 
@@ -69,61 +69,149 @@ MonteCarlo_Init_d (const int rep_begin, const int rep_end)
 
 
 
-__global__ void
-MonteCarlo_d (const int rep_begin, const int rep_end, const int s1, const int s2)
+// steps_per_exchange MC steps of one replica, starting at step s1 + s2
+
+__device__ void
+MonteCarloSteps_d (const int bidx, const int myreplica, const int rep_begin,
+		   const int s1, const int s2)
 {
-  const int bidx = blockDim.x * threadIdx.y + threadIdx.x;      // within a TB
+  __shared__ int conf_trial; // conformer of a switch trial, -1 for a rigid move
 
-  //__shared__ LigCoord myligcoord[1];
+  Ligand *mylig = &lig_dc[replica_dc[myreplica].idx_rep];
+  const Protein *myprt = &prt_dc[replica_dc[myreplica].idx_prt];
+  const float mybeta_end = temp_dc[replica_dc[myreplica].idx_tmp].minus_beta;
+  // printf("mybeta: %f\n", mybeta);
 
-  for (int offset = rep_begin; offset <= rep_end; offset += GD) {
-    const int myreplica = offset + blockIdx.x;
 
-    /*
+  for (int s3 = 0; s3 < steps_per_exchange_dc; ++s3) {
+    const float mybeta = AnnealMinusBeta (anneal_mode_dc, anneal_temp_dc, anneal_cycles_dc,
+					  mybeta_end, s1 + s2 + s3, steps_total_dc);
+
     if (bidx == 0) {
-      printf ("%3d : %3d\n", myreplica, replica_dc[myreplica].idx_rep);
+      conf_trial = -1;
+      if (conf_switch_prob_dc > 0.0f && MyRand_d () < conf_switch_prob_dc) {
+	const int c = min ((int) (MyRand_d () * n_lig_dc), n_lig_dc - 1);
+	if (c != replica_dc[myreplica].idx_lig)
+	  conf_trial = c;
+      }
     }
-    */
-
-    if (myreplica <= rep_end) {
-      Ligand *mylig = &lig_dc[replica_dc[myreplica].idx_rep];
-      const Protein *myprt = &prt_dc[replica_dc[myreplica].idx_prt];
-      const float mybeta = temp_dc[replica_dc[myreplica].idx_tmp].minus_beta;
-      // printf("mybeta: %f\n", mybeta);
+    __syncthreads ();
+    const int myconf_trial = conf_trial;
 
-
-      for (int s3 = 0; s3 < steps_per_exchange_dc; ++s3) {
-	
+    if (myconf_trial >= 0) {
+      // switch the conformer, keep the pose
+      SwitchConf_d (bidx, mylig, myconf_trial);
+      Move_d (bidx, mylig, 0.0f);
+    }
+    else {
 #if IS_CONTROL_MOVE == 1
-	Move_d (bidx, mylig, 2.0f);
+      Move_d (bidx, mylig, 2.0f);
 #else
-	Move_d (bidx, mylig, 2.0f * MyRand_d() - 1.0f);
+      Move_d (bidx, mylig, 2.0f * MyRand_d() - 1.0f);
 #endif
+    }
 
 #if IS_CALCU_RMSD == 1
-        CalcRmsd_d (bidx, mylig);
+    CalcRmsd_d (bidx, mylig);
 #endif
 
 #if IS_CALCU_MCC == 1
-	CalcMcc_d (bidx, mylig, myprt);
+    CalcMcc_d (bidx, mylig, myprt);
 #endif 
 
-	CalcEnergy_d (bidx, mylig, myprt);
-	Accept_d (bidx, mylig, mybeta, myreplica);
+    CalcEnergy_d (bidx, mylig, myprt);
+    Accept_d (bidx, mylig, mybeta, myreplica);
+
+    if (myconf_trial >= 0) {
+      if (mylig->is_move_accepted == 1) {
+	if (bidx == 0)
+	  replica_dc[myreplica].idx_lig = myconf_trial;
+      }
+      else {
+	SwitchConf_d (bidx, mylig, replica_dc[myreplica].idx_lig);
+      }
+      __syncthreads ();
+    }
 
 #if IS_OUTPUT == 1
-	// record old status
-	RecordLigand_d (bidx, s1, s2 + s3, myreplica, rep_begin, mylig);
+    // record old status
+    RecordLigand_d (bidx, s1, s2 + s3, myreplica, rep_begin, mylig);
 #endif
-      }
+  }
 
-      if (bidx == 0) {
-	etotal_dc[myreplica] = mylig->energy_old.e[MAXWEI - 1];
-	for (int i = 0; i < 6; ++i)
-	  ligmovevector_dc[myreplica].ele[i] = mylig->movematrix_old[i];
-      }
+  if (bidx == 0) {
+    etotal_dc[myreplica] = mylig->energy_old.e[MAXWEI - 1];
+    for (int i = 0; i < 6; ++i)
+      ligmovevector_dc[myreplica].ele[i] = mylig->movematrix_old[i];
+  }
+}
+
+
+
+__global__ void
+MonteCarlo_d (const int rep_begin, const int rep_end, const int s1, const int s2)
+{
+  const int bidx = blockDim.x * threadIdx.y + threadIdx.x;      // within a TB
+
+  for (int offset = rep_begin; offset <= rep_end; offset += GD) {
+    const int myreplica = offset + blockIdx.x;
+
+    /*
+    if (bidx == 0) {
+      printf ("%3d : %3d\n", myreplica, replica_dc[myreplica].idx_rep);
     }
+    */
+
+    if (myreplica <= rep_end)
+      MonteCarloSteps_d (bidx, myreplica, rep_begin, s1, s2);
   }
 
 }
 
+
+
+// persistent version of MonteCarlo_d, runs n_intervals exchange intervals
+// without returning to the host
+// with exchange, each block owns the n_tmp replicas sharing a protein and a
+// ligand conformer and exchanges their temperatures in block, without, the
+// blocks stride over the replicas one at a time like MonteCarlo_d
+
+__global__ void
+MonteCarloPersistent_d (const int rep_begin, const int rep_end, const int s1,
+			const int n_intervals)
+{
+  const int bidx = blockDim.x * threadIdx.y + threadIdx.x;      // within a TB
+
+#if IS_EXCHANGE == 1
+  const int p_begin = rep_begin / (n_tmp_dc * n_lig_dc);
+  const int n_group = (rep_end - rep_begin + 1) / n_tmp_dc;
+
+  for (int g = blockIdx.x; g < n_group; g += GD) {
+    const int p = p_begin + g / n_lig_dc;
+    const int l = g % n_lig_dc;
+
+    for (int iv = 0; iv < n_intervals; ++iv) {
+      const int s2 = iv * steps_per_exchange_dc;
+
+      for (int t = 0; t < n_tmp_dc; ++t) {
+	const int myreplica = n_tmp_dc * n_lig_dc * p + n_lig_dc * t + l;
+	MonteCarloSteps_d (bidx, myreplica, rep_begin, s1, s2);
+      }
+
+      __syncthreads ();
+      if (bidx == 0)
+	ExchangeTemperatures_d (p, l, !(iv % 2));
+      __syncthreads ();
+    }
+  }
+#else
+  for (int offset = rep_begin; offset <= rep_end; offset += GD) {
+    const int myreplica = offset + blockIdx.x;
+
+    if (myreplica <= rep_end)
+      for (int iv = 0; iv < n_intervals; ++iv)
+	MonteCarloSteps_d (bidx, myreplica, rep_begin, s1, iv * steps_per_exchange_dc);
+  }
+#endif
+
+}
@@ -0,0 +1,52 @@
+/*
+#include <cstdio>
+
+#include "dock.h"
+#include "gpu.cuh"
+*/
+
+
+
+// replace the conformer of a ligand replica by conformer idx_conf of the
+// library, the pose (movematrix and pocket center) stays untouched
+
+__device__ void
+SwitchConf_d (const int bidx, Ligand * __restrict__ mylig, const int idx_conf)
+{
+  const LigCoord *myconf = &ligconf_dc[idx_conf];
+  LigCoord *coord_orig = &mylig->coord_orig;
+
+  for (int l = bidx; l < lna_dc; l += TperB) {
+    coord_orig->x[l] = myconf->x[l];
+    coord_orig->y[l] = myconf->y[l];
+    coord_orig->z[l] = myconf->z[l];
+  }
+
+  __syncthreads ();
+}
+
+
+
+// the replica swapping conformers with myreplica, -1 if none
+// neighbors in the ligand dimension, same protein and temperature slot
+// mode 0: 0 swap 1 , 2 swap 3 , 4 swap 5 , ...
+// mode 1: 0 , 1 swap 2 , 3 swap 4 , ...
+
+__device__ int
+ConfPartner_d (const int myreplica, const int mode_l)
+{
+  const int l = myreplica % n_lig_dc;
+  int l2;
+
+  if (mode_l == 0)
+    l2 = (l % 2 == 0) ? l + 1 : l - 1;
+  else if (mode_l == 1)
+    l2 = (l % 2 == 1) ? l + 1 : l - 1;
+  else
+    return -1;
+
+  if (l2 < 0 || l2 >= n_lig_dc)
+    return -1;
+
+  return myreplica - l + l2;
+}
@@ -85,23 +85,23 @@ RecordLigand_d (const int bidx, const int s1, const int s2s3,
      }
    */
 
+  // slots past tail + capacity still hold records the host has not drained
   if (bidx == 0) {
     if (mylig->is_move_accepted == 1) {
-      const int next_ptr = ligrecord_dc[myreplica - rep_begin].next_ptr;
-      ligrecord_dc[myreplica - rep_begin].next_ptr = next_ptr + 1;
-
-    /*
-    if (myreplica == 0)
-      printf ("record_d: nex_ptr %d iter %d\n", next_ptr + 1, s2s3);
-    */
-
-      LigRecordSingleStep *myrecord = &ligrecord_dc[myreplica - rep_begin].step[next_ptr];
-
-      myrecord->replica = replica_dc[myreplica];
-      myrecord->energy = mylig->energy_old;
-      for (int i = 0; i < 6; ++i)
-	myrecord->movematrix[i] = mylig->movematrix_old[i];
-      myrecord->step = s1 + s2s3;
+      const unsigned long long pos = atomicAdd (&recordring_dc->head, 1ULL);
+
+      if (pos - recordring_dc->tail < recordring_dc->capacity) {
+	LigRecordSingleStep *myrecord = &ligring_dc[pos % recordring_dc->capacity];
+
+	myrecord->replica = replica_dc[myreplica];
+	myrecord->energy = mylig->energy_old;
+	for (int i = 0; i < 6; ++i)
+	  myrecord->movematrix[i] = mylig->movematrix_old[i];
+	myrecord->step = s1 + s2s3;
+      }
+      else {
+	atomicAdd (&recordring_dc->n_dropped, 1);
+      }
     }
   }
 
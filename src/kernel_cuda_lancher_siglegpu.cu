@@ -6,66 +6,156 @@ double t1 = HostTimeNow ();
 
 int i = 0;
 cudaSetDevice (i);
-CUDAKERNELSYNC (ResetCounter_d, dim_grid, dim_block, rep_begin[i], rep_end[i]);
+
+// persistent execution: one MonteCarloPersistent_d launch per dump, the
+// exchange intervals and temperature exchanges run inside the kernel
+// the accepted states go to the device trajectory ring, the positions a launch
+// filled are copied back on a second stream while the GPU runs the next dump,
+// and handed to the background consumer of record_drain.C and to the output
+// thread of async_writer.C
+cudaStream_t stream, stream_copy;
+cudaEvent_t ev_start, ev_stop;
+CE1 (cudaStreamCreate (&stream));
+CE1 (cudaStreamCreate (&stream_copy));
+CE1 (cudaEventCreate (&ev_start));
+CE1 (cudaEventCreate (&ev_stop));
+
+// the host buffer holds the expected accepted states of one dump, a larger
+// batch is drained in several copies
+const unsigned long long ring_cap = mcpara->record_cap;
+unsigned long long rec_cap = (unsigned long long) n_rep *
+  (1 + (int) (RECORD_ACCEPT_RATIO * mcpara->steps_per_dump));
+if (rec_cap > ring_cap)
+  rec_cap = ring_cap;
+RecordRing *ring_h;
+LigRecordSingleStep *rec_h;
+CE1 (cudaMallocHost ((void **) &ring_h, sizeof (RecordRing)));
+CE1 (cudaMallocHost ((void **) &rec_h, sizeof (LigRecordSingleStep) * rec_cap));
+
+RecordDrain *drain = StartRecordDrain (RECORD_DRAIN_SZ, &records, online);
+
+// a single HDF5 file and a single compressed trajectory for the whole run,
+// written by the output thread while sampling continues
+H5Traj *h5traj = NULL;
+if (strlen (mcpara->hdf_path) != 0)
+  h5traj = OpenH5Traj (mcpara->hdf_path);
+TrajWriter *traj = NULL;
+if (strlen (mcpara->traj_path) != 0)
+  traj = OpenTrajWriter (mcpara->traj_path, mcpara->traj_energy);
+AsyncWriter *writer = StartAsyncWriter (ASYNC_WRITER_DEPTH, h5traj, traj);
+
+// the initial states open the ring
+ring_h->head = 0;
+ring_h->tail = 0;
+ring_h->capacity = ring_cap;
+ring_h->n_dropped = 0;
+CUDAMEMCPY (recordring_d[i], ring_h, sizeof (RecordRing), cudaMemcpyHostToDevice);
 CUDAKERNELSYNC (MonteCarlo_Init_d, dim_grid, dim_block, rep_begin[i], rep_end[i]);
+CUDAMEMCPY (ring_h, recordring_d[i], sizeof (RecordRing), cudaMemcpyDeviceToHost);
+
+// positions [pend_begin, pend_end) hold the records of the last launch
+unsigned long long pend_begin = 0;
+unsigned long long pend_end = ring_h->head < ring_cap ? ring_h->head : ring_cap;
+mclog->n_dropped += ring_h->n_dropped;
+int n_drained = 0;
 
+// population control buffers
+float *etotal = (float *) malloc (etotal_sz);
+int *prune = (int *) malloc (prune_sz);
+int *prune_dst = (int *) malloc (sizeof (int) * n_rep);
+int *prune_src = (int *) malloc (sizeof (int) * n_rep);
+
+const int n_intervals = mcpara->steps_per_dump / mcpara->steps_per_exchange;
 int s1 = 0;
 int est_tot_rec = mcpara->steps_per_dump * complexsize.n_rep;
 printf("estimated total records: %d\n", est_tot_rec);
 // int est_tot_rec = MINIMUM_REC;
 
-while(CountValidRecords(multi_reps_records) < est_tot_rec) {
-
-  // skip the reset if since it has been performed before MC_init
-  if (s1 != 0)
-    CUDAKERNELSYNC (ResetCounter_d, dim_grid, dim_block, rep_begin[i], rep_end[i]);
+while(n_drained + (int) (pend_end - pend_begin) < est_tot_rec) {
 
-  double t0 = HostTimeNow ();
+  // moves across blocks, applied at the dump boundaries
+  if (mcpara->is_conf_exchange) {
+    const int mode_l = (s1 / mcpara->steps_per_dump) % 2;
+    CUDAKERNELSTREAM (CalcSwapEnergy_d, dim_grid, dim_block, 0, stream, rep_begin[i], rep_end[i], mode_l);
+    CUDAKERNELSTREAM (ExchangeReplicas_d, dim_grid, dim_block, 0, stream, mode_l, 4);
+  }
 
-  for (int s2 = 0; s2 < mcpara->steps_per_dump; s2 += mcpara->steps_per_exchange) {
-    CUDAKERNELSYNC (MonteCarlo_d, dim_grid, dim_block, rep_begin[i], rep_end[i], s1, s2);
-# if IS_EXCHANGE == 1
-    const int mode_l = 4; // ligand exchange mode
-    const int mode_t = !((s2 / mcpara->steps_per_exchange) % 2); // temperature exchange mode
-    CUDAKERNELSYNC (ExchangeReplicas_d, dim_grid, dim_block, mode_l, mode_t);
-# endif
+  // retire the highest energy replicas every prune_every steps
+  if (mcpara->prune_every > 0 && s1 > 0 &&
+      s1 / mcpara->prune_every != (s1 - mcpara->steps_per_dump) / mcpara->prune_every) {
+    CE1 (cudaMemcpyAsync (etotal, etotal_d[i], etotal_sz, cudaMemcpyDeviceToHost, stream));
+    CE1 (cudaStreamSynchronize (stream));
+    const int n_pairs = PlanReplicaPruning (etotal, n_rep, mcpara->prune_frac, prune_dst, prune_src);
+    if (n_pairs > 0) {
+      for (int k = 0; k < n_pairs; ++k) {
+        prune[2 * k] = prune_dst[k];
+        prune[2 * k + 1] = prune_src[k];
+      }
+      CE1 (cudaMemcpyAsync (prune_d[i], prune, sizeof (int) * 2 * n_pairs, cudaMemcpyHostToDevice, stream));
+      CUDAKERNELSTREAM (CloneReplicas_d, dim_grid, dim_block, 0, stream, n_pairs);
+      mclog->n_pruned += n_pairs;
+    }
   }
 
-  // accumulate for compute time
-  mclog->t0 += HostTimeNow () - t0;
+  // run the dump, the ring keeps the records of the last launch until drained
+  ring_h->head = pend_end;
+  ring_h->tail = pend_begin;
+  ring_h->n_dropped = 0;
+  CE1 (cudaMemcpyAsync (recordring_d[i], ring_h, sizeof (RecordRing), cudaMemcpyHostToDevice, stream));
 
+  CE1 (cudaEventRecord (ev_start, stream));
+  CUDAKERNELSTREAM (MonteCarloPersistent_d, dim_grid, dim_block, 0, stream, rep_begin[i], rep_end[i], s1, n_intervals);
+  CE1 (cudaEventRecord (ev_stop, stream));
 
-  // copy ligand record from GPU to CPU memory
-  CUDAMEMCPY (&ligrecord[rep_begin[i]], ligrecord_d[i], ligrecord_sz_per_gpu[i], cudaMemcpyDeviceToHost);
+  CE1 (cudaMemcpyAsync (ring_h, recordring_d[i], sizeof (RecordRing), cudaMemcpyDeviceToHost, stream));
 
-  // gather ligand record
-  for (int rep = rep_begin[i]; rep <= rep_end[i]; ++rep) {
-    for (int s = 0; s < ligrecord[rep].next_ptr; ++s) {
-      LigRecordSingleStep my_step = ligrecord[rep].step[s];
-      multi_reps_records[rep].push_back(my_step);
-    }
-  }
 
-  printf("# points\t\t\t%d\n", CountValidRecords(multi_reps_records));
-  fflush (stdout);
+  // drain the last launch while the GPU works on this one
+  DrainRingRecords (rec_h, rec_cap, ligring_d[i], ring_cap, pend_begin, pend_end,
+		    stream_copy, drain, writer);
+  n_drained += pend_end - pend_begin;
+
+  CE1 (cudaStreamSynchronize (stream));
+
+  // accumulate for compute time
+  float compute_ms;
+  CE1 (cudaEventElapsedTime (&compute_ms, ev_start, ev_stop));
+  mclog->t0 += compute_ms / 1000.0;
 
+  // reservations past tail + capacity were dropped
+  pend_begin = pend_end;
+  pend_end = ring_h->head < ring_h->tail + ring_cap ? ring_h->head : ring_h->tail + ring_cap;
+  mclog->n_dropped += ring_h->n_dropped;
 
-#if IS_OUTPUT == 0
-    
-  // dump ligand record from CPU memory to disk
-  if (!(strlen(mcpara->hdf_path) == 0))
-    DumpLigRecord (ligrecord, n_rep, mcpara->hdf_path);
+  char progress[64];
+  sprintf (progress, "# points\t\t\t%d\n", n_drained + (int) (pend_end - pend_begin));
+  SubmitLog (writer, progress);
 
-#endif
-    
-  // accumulate for wall time (compute time plus I/O time)
   s1 += mcpara->steps_per_dump;
  }
 
+// drain the last dump
+DrainRingRecords (rec_h, rec_cap, ligring_d[i], ring_cap, pend_begin, pend_end,
+		  stream_copy, drain, writer);
+n_drained += pend_end - pend_begin;
+mclog->t2 += StopAsyncWriter (writer);
+mclog->n_waits += StopRecordDrain (drain);
+GroupByReplica (&records, n_rep);
+
+free (etotal);
+free (prune);
+free (prune_dst);
+free (prune_src);
+
+cudaFreeHost (rec_h);
+cudaFreeHost (ring_h);
+cudaEventDestroy (ev_start);
+cudaEventDestroy (ev_stop);
+cudaStreamDestroy (stream_copy);
+cudaStreamDestroy (stream);
+
 mclog->t1 += HostTimeNow () - t1;
 mclog->steps_total = s1;
 
 int trials = complexsize.n_rep * s1;
-mclog->ar = (float) CountValidRecords(multi_reps_records) / (float) trials;
-
-
+mclog->ar = (float) n_drained / (float) trials;
@@ -8,6 +8,7 @@
 #include <assert.h>
 
 #include "size.h"
+#include "dist_mat.h"
 
 extern "C" {
 #include "./modules/cluster-1.52a/src/cluster.h" /* The C Clustering Library */
@@ -20,6 +21,7 @@ map < int, vector < int > > GetClusters(int* clusterid, int ncluster, int nobj);
 
 // dictionary of a point and its total distance to others
 map < int, double > Distances2Others(vector < int > &members, double** distmatrix);
+map < int, double > Distances2Others(vector < int > &members, const DistMat & distmatrix);
 
 // find the idx of the medoid in a cluster
 // defined as the point with the minimum average distance to all others
@@ -28,8 +30,21 @@ int FindMedoid(map < int, double > & pt_and_its_dist_to_others);
 double SpreadOfCluster(map < int, double > &pt_and_its_dist_to_others);
 
 double AveSpread(map < int, vector < int > > & clusters, double** dist_matrix);
+double AveSpread(map < int, vector < int > > & clusters, const DistMat & dist_matrix);
 
-// find the number of clusters that gives the smallest KGS penalty
+// find the number of clusters that gives the smallest KGS penalty, and cut
+// the tree into as many clusters in clusterid
+// the spreads of all the cuts come from one pass over the merges of the tree
 int KGS(Node* tree, int* clusterid, double** dist_matrix, int nobj, bool show_penalties);
+int KGS(Node* tree, int* clusterid, const DistMat & dist_matrix, int nobj, bool show_penalties);
+
+// treecluster of the condensed matrix, single linkage ('s') reads it in
+// place, average linkage ('a') is a nearest neighbor chain in O(n^2) time
+// on a copy, the other methods go through a temporary lower triangle
+Node* TreeCluster(const DistMat & distmatrix, char method);
+
+// TreeCluster, but average linkage ('a') runs without the copy and leaves
+// its working distances in the matrix, for callers done with the distances
+Node* TreeClusterInPlace(DistMat & distmatrix, char method);
 
 #endif // UTIL_H
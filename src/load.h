@@ -45,6 +45,7 @@ void loadLigand_bk(LigandFile *, Ligand0 *);
 
 void loadPrtConf(ProteinFile *, Protein0 *);
 void loadProtein(ProteinFile *, Protein0 *);
+void loadProtein_bk(ProteinFile *, Protein0 *);
 
 void loadPocketCenter(string, float *);
 void loadLHM(LhmFile *, Psp0 *, Kde0 *, Mcs0 *);
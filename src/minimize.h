@@ -0,0 +1,52 @@
+#ifndef MINIMIZE_H
+#define MINIMIZE_H
+
+#include <vector>
+
+#include "size.h"
+#include "dock.h"
+#include "record_store.h"
+
+using namespace std;
+
+// minimize.C
+// local refinement of poses over the 6 rigid body DOF of the movematrix,
+// using the Nelder-Mead simplex method on the host side energy (energy.C)
+
+// contact matrix of the first conformer at its initial placement,
+// the reference InitRefMatrix_d uses for the cms of all replicas
+void InitRefContactMatrix(int *ref_matrix, Ligand *lig,
+                          const Protein *const prt,
+                          const EnePara *const enepara);
+
+// refine one step in place: movematrix, energy, cms and rmsd
+// the step is left untouched if no lower energy is found
+// returns the energy gain (>= 0)
+float MinimizePose(LigRecordSingleStep *step, const Ligand *const lig,
+                   const Protein *const prt, const Psp *const psp,
+                   const Kde *const kde, const Mcs *const mcs,
+                   const EnePara *const enepara, const McPara *const mcpara,
+                   const int pos, int *ref_matrix);
+
+// refine a batch of steps in parallel
+void MinimizePoses(vector<LigRecordSingleStep *> &steps, const Ligand *const lig,
+                   const Protein *const prt, const Psp *const psp,
+                   const Kde *const kde, const Mcs *const mcs,
+                   const EnePara *const enepara, const McPara *const mcpara,
+                   const int pos);
+
+// refine every mcpara->min_every -th accepted state of each replica
+void MinimizeRecords(RecordStore &records,
+                     const Ligand *const lig, const Protein *const prt,
+                     const Psp *const psp, const Kde *const kde,
+                     const Mcs *const mcs, const EnePara *const enepara,
+                     const McPara *const mcpara, const int pos);
+
+// refine the cluster medoids, and re-sort them by energy
+void MinimizeMedoids(vector<Medoid> &medoids, const Ligand *const lig,
+                     const Protein *const prt, const Psp *const psp,
+                     const Kde *const kde, const Mcs *const mcs,
+                     const EnePara *const enepara, const McPara *const mcpara,
+                     const int pos);
+
+#endif // MINIMIZE_H
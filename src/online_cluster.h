@@ -0,0 +1,49 @@
+#ifndef ONLINE_CLUSTER_H
+#define ONLINE_CLUSTER_H
+
+#include <vector>
+
+#include "size.h"
+#include "dock.h"
+
+using namespace std;
+
+// online_cluster.C
+// mini-batch k-means over the energy terms of the accepted states, fed by the
+// record consumer of record_drain.C while sampling runs, in place of keeping
+// every state for post_mc
+//
+// the first ONLINE_SEED_FACTOR * k states are kept and clustered by
+// ParKmeans, from then on each batch is assigned to the nearest centers and
+// every center moves toward its new members with the rate 1 / its size
+// each cluster keeps the state nearest to its current center as the medoid,
+// the memory is bounded by k whatever the length of the run
+
+#define ONLINE_SEED_FACTOR 20
+#define ONLINE_FEATURES (MAXWEI - 1)
+
+struct OnlineClusters
+{
+  int k;         // clusters
+  int n_seen;    // states fed so far
+  bool seeded;
+
+  vector<LigRecordSingleStep> seed; // the first states, until seeded
+
+  vector<float> center;  // [k][ONLINE_FEATURES]
+  vector<int> size;      // states assigned to each cluster
+  vector<LigRecordSingleStep> medoid;
+  vector<float> medoid_d2; // squared distance of the medoid to its center
+};
+
+void InitOnlineClusters(OnlineClusters *online, const int k);
+
+// feed n accepted states, one mini-batch
+void AddOnlineRecords(OnlineClusters *online, const LigRecordSingleStep *steps,
+                      const int n);
+
+// the medoids by increasing total energy, clusters the states fed so far if
+// there were fewer than the seed
+vector<Medoid> OnlineMedoids(OnlineClusters *online);
+
+#endif // ONLINE_CLUSTER_H
@@ -0,0 +1,33 @@
+#ifndef PAR_KMEANS_H
+#define PAR_KMEANS_H
+
+// par_kmeans.C
+// k-means over numObjs points of numCoords contiguous floats, objects[i *
+// numCoords + j] is feature j of point i
+//
+// the centers are seeded by k-means++ from seed, and the Lloyd iterations
+// skip the points whose Hamerly bounds prove the assignment unchanged, the
+// result is the one of the plain Lloyd iterations from the same seeds
+//
+// the iterations stop once at most threshold of the points change their
+// cluster, or after max_iter iterations, as in seq_kmeans
+//
+// membership gets numObjs cluster ids, clusters numClusters * numCoords
+// centers, returns the number of iterations
+// numClusters <= numObjs
+
+int ParKmeans(const float *objects, const int numObjs, const int numCoords,
+              const int numClusters, const float threshold, const int max_iter,
+              const unsigned seed, int *membership, float *clusters);
+
+// squared euclidean distance of two points
+static inline float KmeansDist2(const float *a, const float *b, const int numCoords)
+{
+  float s = 0.0f;
+#pragma omp simd reduction(+:s)
+  for (int j = 0; j < numCoords; ++j)
+    s += (a[j] - b[j]) * (a[j] - b[j]);
+  return s;
+}
+
+#endif // PAR_KMEANS_H
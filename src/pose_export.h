@@ -0,0 +1,32 @@
+#ifndef POSE_EXPORT_H
+#define POSE_EXPORT_H
+
+#include <vector>
+
+#include "size.h"
+#include "dock.h"
+
+using namespace std;
+
+// pose_export.C
+// re-scoring of the cluster medoids and their export to a single SDF file
+//
+// the poses are placed and scored on the host in parallel, then streamed out
+// one after another, each one the connection table of the input molecule with
+// its placed coordinates and the re-scored energy terms as data items
+
+// the energy terms, in the order of energy.e[]
+extern const char *const EXPORT_TERM_TAGS[MAXWEI];
+
+// place the n_top lowest medoids, all of them for n_top <= 0, and write them
+// to out_path, the atom block comes from the first molecule of sdf_path
+// the medoids are taken in the order given, sorted by energy after clustering
+// returns the number of poses written
+int ExportMedoidsSdf(const vector<Medoid> &medoids, const int n_top,
+                     const char *sdf_path, const char *out_path,
+                     const Ligand *const lig, const Protein *const prt,
+                     const Psp *const psp, const Kde *const kde,
+                     const Mcs *const mcs, const EnePara *const enepara,
+                     const int pos);
+
+#endif // POSE_EXPORT_H
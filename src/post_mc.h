@@ -6,21 +6,22 @@
 
 #include "dock.h"
 #include "util.h"
+#include "record_store.h"
 
 using namespace std;
 
 std::vector<Medoid>
-    post_mc(map<int, vector<LigRecordSingleStep> > multi_reps_records,
+    post_mc(const RecordStore &records,
             Ligand *lig, const Protein *const prt, const EnePara *const enepara,
             const McPara *const mcpara);
 
 vector<Medoid>
-cluster_trajectories(map < int, vector < LigRecordSingleStep > > & multi_reps_records,
+cluster_trajectories(const RecordStore & records,
                      Ligand* lig, int n_lig,
                      const Protein* const prt, 
                      const EnePara* const enepara);
 
-void opt_ff(map<int, vector<LigRecordSingleStep> > &multi_reps_records,
+void opt_ff(const RecordStore &records,
             Ligand *lig, int n_lig, const Protein *const prt,
             const EnePara *const enepara, const McPara *const mcpara);
 
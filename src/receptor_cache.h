@@ -0,0 +1,58 @@
+#ifndef RECEPTOR_CACHE_H
+#define RECEPTOR_CACHE_H
+
+#include <string>
+#include <cstddef>
+
+#include "dock.h"
+
+// receptor_cache.C
+// binary cache of the optimized receptor, written once by "dock prepare" and
+// mapped by every docking run against the same receptor
+//
+//   header   magic "GXRC", version, the MAX* sizes of size.h and the struct
+//            sizes of the build, the protein conformation, point and MCS
+//            position counts, the complex id, the section offsets, and the
+//            FNV-1a checksum of the payload
+//   payload  Protein[n_prt], Psp, Kde, Mcs[pos] and EnePara, each at a
+//            RECEPTOR_CACHE_ALIGN byte offset, as laid out in memory
+//
+// the structs are stored in native byte order, a cache only loads into a
+// build with the same size.h
+
+#define RECEPTOR_CACHE_ALIGN 64
+
+// the file is mapped copy on write, the structs may be adjusted in place,
+// e.g. the pocket center, without touching the file or the other processes
+struct ReceptorCache
+{
+  void *map;
+  size_t map_sz;
+
+  std::string ligand_id;
+  int n_prt;  // protein conformations
+  int pnp;    // protein effective points
+  int pos;    // MCS positions
+
+  Protein *prt;
+  Psp *psp;
+  Kde *kde;
+  Mcs *mcs;
+  EnePara *enepara;
+};
+
+// load the protein, force field and parameter files of inputfiles, optimize
+// them, and write the cache to path
+void PrepareReceptorCache(InputFiles *inputfiles, const char *path);
+
+void WriteReceptorCache(const char *path, const std::string &ligand_id,
+                        const Protein *prt, const int n_prt, const Psp *psp,
+                        const Kde *kde, const Mcs *mcs, const int pos,
+                        const EnePara *enepara);
+
+// exits on a missing, truncated, corrupt or incompatible cache
+ReceptorCache *OpenReceptorCache(const char *path);
+
+void CloseReceptorCache(ReceptorCache *cache);
+
+#endif // RECEPTOR_CACHE_H
@@ -0,0 +1,31 @@
+#ifndef RECORD_DRAIN_H
+#define RECORD_DRAIN_H
+
+#include "dock.h"
+#include "record_store.h"
+#include "online_cluster.h"
+
+using namespace std;
+
+// record_drain.C
+// the launcher hands the accepted states to a background consumer thread
+// through a lock-free ring buffer (ring_buffer.h), the consumer appends them
+// to the columnar store in batches, or with an online clustering, feeds the
+// batches to it and keeps no state
+
+struct RecordDrain;
+
+// start the consumer, the ring holds capacity records, online is NULL to
+// keep every state in the store
+// the store and online must not be touched until StopRecordDrain returns
+RecordDrain *StartRecordDrain(const int capacity, RecordStore *store,
+                              OnlineClusters *online);
+
+// append n records, blocks while the ring is full
+void PushRecords(RecordDrain *drain, const LigRecordSingleStep *steps, const int n);
+
+// drain what is left and join the consumer
+// returns the number of times the producer had to wait for a free slot
+int StopRecordDrain(RecordDrain *drain);
+
+#endif // RECORD_DRAIN_H
@@ -0,0 +1,43 @@
+#ifndef RECORD_STORE_H
+#define RECORD_STORE_H
+
+#include <vector>
+
+#include "size.h"
+#include "dock.h"
+
+using namespace std;
+
+// record_store.C
+// columnar store of the accepted states, one contiguous array per field of
+// LigRecordSingleStep, row i of every column belongs to the same state
+
+struct RecordStore
+{
+  vector<int> idx_rep;
+  vector<int> idx_prt;
+  vector<int> idx_tmp;
+  vector<int> idx_lig;
+  vector<int> step;
+  vector<float> movematrix[6]; // translation x y z, rotation x y z
+  vector<float> e[MAXWEI];
+  vector<float> cms;
+  vector<float> rmsd;
+
+  // after GroupByReplica, the rows of replica r are [rep_ptr[r], rep_ptr[r + 1])
+  vector<int> rep_ptr;
+};
+
+int CountRecords(const RecordStore &store);
+
+// append n states at the end of every column
+void AppendRecords(RecordStore *store, const LigRecordSingleStep *steps, const int n);
+
+// stable reorder of the rows by replica, and build rep_ptr
+void GroupByReplica(RecordStore *store, const int n_rep);
+
+void GetRecord(const RecordStore &store, const int row, LigRecordSingleStep *step);
+
+void SetRecord(RecordStore *store, const int row, const LigRecordSingleStep *step);
+
+#endif // RECORD_STORE_H
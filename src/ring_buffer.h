@@ -0,0 +1,58 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+// bounded lock-free queue for one producer and one consumer thread
+// the capacity is rounded up to a power of two
+// head is only written by the consumer, tail only by the producer
+
+template <typename T>
+class RingBuffer
+{
+public:
+  explicit RingBuffer(const size_t capacity) : head(0), tail(0) {
+    size_t sz = 1;
+    while (sz < capacity)
+      sz <<= 1;
+    buf.resize(sz);
+    mask = sz - 1;
+  }
+
+  size_t capacity() const { return buf.size(); }
+
+  // false if the ring is full
+  bool push(const T &item) {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == buf.size())
+      return false;
+    buf[t & mask] = item;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // false if the ring is empty
+  bool pop(T &item) {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return false;
+    item = buf[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+
+private:
+  std::vector<T> buf;
+  size_t mask;
+  std::atomic<size_t> head; // next slot to pop
+  std::atomic<size_t> tail; // next slot to push
+};
+
+#endif // RING_BUFFER_H
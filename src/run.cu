@@ -8,6 +8,7 @@
 #include "size.h"
 #include "toggle.h"
 #include "hdf5io.h"
+#include "anneal.h"
 
 #include <cuda.h>
 #include <curand.h>
@@ -16,6 +17,8 @@
 #include "dock.h"
 #include "toggle.h"
 #include "util.h"
+#include "record_drain.h"
+#include "async_writer.h"
 #include "kernel_cuda.cuh"
 
 
@@ -29,6 +32,46 @@
 
 
 
+// copy the ring slots of positions [begin, end) to dst, the range wraps
+// around the end of the ring at most once
+static void
+CopyRingRecords (LigRecordSingleStep * dst, const LigRecordSingleStep * ring_d,
+		 const unsigned long long capacity,
+		 const unsigned long long begin, const unsigned long long end,
+		 cudaStream_t stream)
+{
+  const unsigned long long first = begin % capacity;
+  const unsigned long long n = end - begin;
+  const unsigned long long n1 = n < capacity - first ? n : capacity - first;
+
+  if (n1 > 0)
+    CE1 (cudaMemcpyAsync (dst, ring_d + first, sizeof (LigRecordSingleStep) * n1,
+			  cudaMemcpyDeviceToHost, stream));
+  if (n > n1)
+    CE1 (cudaMemcpyAsync (dst + n1, ring_d, sizeof (LigRecordSingleStep) * (n - n1),
+			  cudaMemcpyDeviceToHost, stream));
+}
+
+// hand the ring positions [begin, end) to the consumer and the output thread,
+// through the host buffer of rec_cap records, in as many copies as it takes
+static void
+DrainRingRecords (LigRecordSingleStep * rec_h, const unsigned long long rec_cap,
+		  const LigRecordSingleStep * ring_d,
+		  const unsigned long long capacity,
+		  unsigned long long begin, const unsigned long long end,
+		  cudaStream_t stream, RecordDrain * drain, AsyncWriter * writer)
+{
+  while (begin < end) {
+    const unsigned long long stop = end - begin < rec_cap ? end : begin + rec_cap;
+    CopyRingRecords (rec_h, ring_d, capacity, begin, stop, stream);
+    CE1 (cudaStreamSynchronize (stream));
+    PushRecords (drain, rec_h, stop - begin);
+    SubmitRecords (writer, rec_h, stop - begin);
+    begin = stop;
+  }
+}
+
+
 void
 Run (const Ligand * lig,
      const Protein * prt,
@@ -40,7 +83,8 @@ Run (const Ligand * lig,
      const Replica * replica,
      const McPara * mcpara,
      McLog * mclog,
-     map < int, vector < LigRecordSingleStep > > &multi_reps_records,
+     RecordStore & records,
+     OnlineClusters * online,
      const ComplexSize complexsize)
 {
   //Parameter para;
@@ -85,7 +129,9 @@ Run (const Ligand * lig,
     cudaSetDevice (i);
     cudaFuncSetCacheConfig (MonteCarlo_Init_d, cudaFuncCachePreferShared);
     cudaFuncSetCacheConfig (MonteCarlo_d, cudaFuncCachePreferShared);
+    cudaFuncSetCacheConfig (MonteCarloPersistent_d, cudaFuncCachePreferShared);
     cudaFuncSetCacheConfig (ExchangeReplicas_d, cudaFuncCachePreferShared);
+    cudaFuncSetCacheConfig (CalcSwapEnergy_d, cudaFuncCachePreferShared);
   }
 
 
@@ -100,7 +146,7 @@ Run (const Ligand * lig,
   int rep_begin[NGPU], rep_end[NGPU], n_rep_per_gpu[NGPU];
   for (int i = 0; i < NGPU; ++i) {
     rep_begin[i] = n_rep_per_gpu_max * i;
-    rep_end[i] = minimal_int (rep_begin[i] + n_rep_per_gpu_max - 1, n_rep);
+    rep_end[i] = minimal_int (rep_begin[i] + n_rep_per_gpu_max - 1, n_rep - 1);
     n_rep_per_gpu[i] = rep_end[i] - rep_begin[i] + 1;
   }
 
@@ -113,6 +159,10 @@ Run (const Ligand * lig,
     CUDAMEMCPYTOSYMBOL (steps_total_dc, &mcpara->steps_total, int);
     CUDAMEMCPYTOSYMBOL (steps_per_dump_dc, &mcpara->steps_per_dump, int);
     CUDAMEMCPYTOSYMBOL (steps_per_exchange_dc, &mcpara->steps_per_exchange, int);
+    CUDAMEMCPYTOSYMBOL (anneal_mode_dc, &mcpara->anneal_mode, int);
+    CUDAMEMCPYTOSYMBOL (anneal_temp_dc, &mcpara->anneal_temp, float);
+    CUDAMEMCPYTOSYMBOL (anneal_cycles_dc, &mcpara->anneal_cycles, int);
+    CUDAMEMCPYTOSYMBOL (conf_switch_prob_dc, &mcpara->conf_switch_prob, float);
 
     CUDAMEMCPYTOSYMBOL (enepara_lj0_dc, &enepara->lj0, float);
     CUDAMEMCPYTOSYMBOL (enepara_lj1_dc, &enepara->lj1, float);
@@ -143,6 +193,7 @@ Run (const Ligand * lig,
   const size_t enepara_sz = sizeof (EnePara);
   const size_t temp_sz = sizeof (Temp) * n_tmp;
   const size_t move_scale_sz = sizeof (float) * 6;
+  const size_t ligconf_sz = sizeof (LigCoord) * n_lig;
 
   Protein *prt_d[NGPU];
   Psp *psp_d[NGPU];
@@ -151,6 +202,12 @@ Run (const Ligand * lig,
   EnePara *enepara_d[NGPU];
   Temp *temp_d[NGPU];
   float *move_scale_d[NGPU];
+  LigCoord *ligconf_d[NGPU];
+
+  // conformer library, the first n_lig ligands hold one conformer each
+  LigCoord *ligconf = (LigCoord *) malloc (ligconf_sz);
+  for (int l = 0; l < n_lig; ++l)
+    ligconf[l] = lig[l].coord_orig;
 
   for (int i = 0; i < NGPU; ++i) {
     cudaSetDevice (i);
@@ -161,6 +218,7 @@ Run (const Ligand * lig,
     CUDAMALLOC (enepara_d[i], enepara_sz, EnePara *);
     CUDAMALLOC (temp_d[i], temp_sz, Temp *);
     CUDAMALLOC (move_scale_d[i], move_scale_sz, float *);
+    CUDAMALLOC (ligconf_d[i], ligconf_sz, LigCoord *);
 
     CUDAMEMCPYTOSYMBOL (prt_dc, &prt_d[i], Protein *);
     CUDAMEMCPYTOSYMBOL (psp_dc, &psp_d[i], Psp *);
@@ -169,6 +227,7 @@ Run (const Ligand * lig,
     CUDAMEMCPYTOSYMBOL (enepara_dc, &enepara_d[i], EnePara *);
     CUDAMEMCPYTOSYMBOL (temp_dc, &temp_d[i], Temp *);
     CUDAMEMCPYTOSYMBOL (move_scale_dc, &move_scale_d[i], float *);
+    CUDAMEMCPYTOSYMBOL (ligconf_dc, &ligconf_d[i], LigCoord *);
 
     CUDAMEMCPY (prt_d[i], prt, prt_sz, cudaMemcpyHostToDevice);
     CUDAMEMCPY (psp_d[i], psp, psp_sz, cudaMemcpyHostToDevice);
@@ -177,6 +236,7 @@ Run (const Ligand * lig,
     CUDAMEMCPY (enepara_d[i], enepara, enepara_sz, cudaMemcpyHostToDevice);
     CUDAMEMCPY (temp_d[i], temp, temp_sz, cudaMemcpyHostToDevice);
     CUDAMEMCPY (move_scale_d[i], &mcpara->move_scale, move_scale_sz, cudaMemcpyHostToDevice);
+    CUDAMEMCPY (ligconf_d[i], ligconf, ligconf_sz, cudaMemcpyHostToDevice);
   }
 
 
@@ -189,6 +249,8 @@ Run (const Ligand * lig,
   const size_t ligmovevector_sz = sizeof (LigMoveVector) * n_rep;
   const size_t acs_temp_exchg_sz = sizeof (int) * n_rep; // acceptance counter
   const size_t ref_matrix_sz = sizeof (ConfusionMatrix);
+  const size_t swap_energy_sz = sizeof (Energy) * n_rep;
+  const size_t prune_sz = sizeof (int) * 2 * n_rep; // (dst, src) pairs
   //size_t etotal_sz_per_gpu[NGPU];
   //for (int i = 0; i < NGPU; ++i)
   //etotal_sz_per_gpu[i] = sizeof (float) * n_rep_per_gpu[i];
@@ -199,6 +261,8 @@ Run (const Ligand * lig,
   LigMoveVector *ligmovevector_d[NGPU];
   int *acs_temp_exchg, *acs_temp_exchg_d[NGPU];
   float *ref_matrix_d[NGPU];
+  Energy *swap_energy_d[NGPU];
+  int *prune_d[NGPU];
 
   acs_temp_exchg = (int *) malloc (acs_temp_exchg_sz);
 
@@ -210,6 +274,8 @@ Run (const Ligand * lig,
     CUDAMALLOC (ligmovevector_d[i], ligmovevector_sz, LigMoveVector *);
     CUDAMALLOC (acs_temp_exchg_d[i], acs_temp_exchg_sz, int *);
     CUDAMALLOC (ref_matrix_d[i], ref_matrix_sz, ConfusionMatrix *);
+    CUDAMALLOC (swap_energy_d[i], swap_energy_sz, Energy *);
+    CUDAMALLOC (prune_d[i], prune_sz, int *);
 
     CUDAMEMCPYTOSYMBOL (lig_dc, &lig_d[i], Ligand *);
     CUDAMEMCPYTOSYMBOL (replica_dc, &replica_d[i], Replica *);
@@ -217,6 +283,8 @@ Run (const Ligand * lig,
     CUDAMEMCPYTOSYMBOL (ligmovevector_dc, &ligmovevector_d[i], LigMoveVector *);
     CUDAMEMCPYTOSYMBOL (acs_temp_exchg_dc, &acs_temp_exchg_d[i], int *);
     CUDAMEMCPYTOSYMBOL (ref_matrix_dc, &ref_matrix_d[i], ConfusionMatrix *);
+    CUDAMEMCPYTOSYMBOL (swap_energy_dc, &swap_energy_d[i], Energy *);
+    CUDAMEMCPYTOSYMBOL (prune_dc, &prune_d[i], int *);
 
     CUDAMEMCPY (lig_d[i], lig, lig_sz, cudaMemcpyHostToDevice);
     CUDAMEMCPY (replica_d[i], replica, replica_sz, cudaMemcpyHostToDevice);
@@ -227,18 +295,16 @@ Run (const Ligand * lig,
 
   // GPU writable arrays that spreads over multiple GPUs
 
-  // ligrecord[n_rep]
-  LigRecord *ligrecord, *ligrecord_d[NGPU];
-  const size_t ligrecord_sz = sizeof (LigRecord) * n_rep;
-  size_t ligrecord_sz_per_gpu[NGPU];
-  for (int i = 0; i < NGPU; ++i)
-    ligrecord_sz_per_gpu[i] = sizeof (LigRecord) * n_rep_per_gpu[i];
-
-  ligrecord = (LigRecord *) malloc (ligrecord_sz);
+  // trajectory ring, record_cap accepted states per GPU
+  LigRecordSingleStep *ligring_d[NGPU];
+  RecordRing *recordring_d[NGPU];
+  const size_t ligring_sz = sizeof (LigRecordSingleStep) * mcpara->record_cap;
   for (int i = 0; i < NGPU; ++i) {
     cudaSetDevice (i);
-    CUDAMALLOC (ligrecord_d[i], ligrecord_sz_per_gpu[i], LigRecord *);
-    CUDAMEMCPYTOSYMBOL (ligrecord_dc, &ligrecord_d[i], LigRecord *);
+    CUDAMALLOC (ligring_d[i], ligring_sz, LigRecordSingleStep *);
+    CUDAMEMCPYTOSYMBOL (ligring_dc, &ligring_d[i], LigRecordSingleStep *);
+    CUDAMALLOC (recordring_d[i], sizeof (RecordRing), RecordRing *);
+    CUDAMEMCPYTOSYMBOL (recordring_dc, &recordring_d[i], RecordRing *);
   }
 
   for (int i = 0; i < NGPU; ++i) {
@@ -247,7 +313,6 @@ Run (const Ligand * lig,
 
 
   // ligand conformation records
-  // vector < vector < LigRecordSingleStep > > multi_reps_records;
 
   // launch GPU kernels
   printf ("Start launching kernels\n");
@@ -271,6 +336,7 @@ Run (const Ligand * lig,
     CUDAFREE (enepara_d[i]);
     CUDAFREE (temp_d[i]);
     CUDAFREE (move_scale_d[i]);
+    CUDAFREE (ligconf_d[i]);
 
     CUDAFREE (lig_d[i]);
     CUDAFREE (replica_d[i]);
@@ -278,12 +344,15 @@ Run (const Ligand * lig,
     CUDAFREE (ligmovevector_d[i]);
     CUDAFREE (acs_temp_exchg_d[i]);
     CUDAFREE (ref_matrix_d[i]);
+    CUDAFREE (swap_energy_d[i]);
+    CUDAFREE (prune_d[i]);
 
-    CUDAFREE (ligrecord_d[i]);
+    CUDAFREE (ligring_d[i]);
+    CUDAFREE (recordring_d[i]);
   }
 
   free (acs_temp_exchg);
-  free (ligrecord);
+  free (ligconf);
 
   printf("%s\n", "Kernel completes");
 }
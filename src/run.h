@@ -1,9 +1,9 @@
 #ifndef  RUN_H
 #define  RUN_H
 
-#include <map>
-#include <vector>
 #include "dock.h"
+#include "record_store.h"
+#include "online_cluster.h"
 
 using namespace std;
 
@@ -18,7 +18,8 @@ Run (const Ligand *,
      const Replica *,
      const McPara *,
      McLog *,
-     map < int, vector < LigRecordSingleStep > > & multi_reps_records,
+     RecordStore & records,
+     OnlineClusters * online,
      const ComplexSize);
 
 
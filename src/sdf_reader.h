@@ -0,0 +1,48 @@
+#ifndef SDF_READER_H
+#define SDF_READER_H
+
+#include <vector>
+
+#include "dock.h"
+#include "text_scan.h"
+
+using namespace std;
+
+// sdf_reader.C
+// single pass reader of SDF ligand libraries of any length
+// the library is mapped, each molecule is split into lines once, and the
+// data items are located by their tag lines, nothing is copied
+
+// a data item, "> <TAG>" followed by its lines up to a blank line
+struct SdfItem
+{
+  TextSpan tag;  // the tag line
+  int line_begin, line_end;  // the data lines
+};
+
+struct SdfMolecule
+{
+  vector<TextSpan> lines;  // the record, up to and without "$$$$"
+  vector<SdfItem> items;
+  int lna, lnb;  // atom and bond counts of the counts line
+};
+
+struct SdfReader;
+
+SdfReader *OpenSdfReader(const char *path);
+
+// split the next molecule, false past the last one
+// the spans stay valid until CloseSdfReader
+bool NextSdfMolecule(SdfReader *reader, SdfMolecule *mol);
+
+void CloseSdfReader(SdfReader *reader);
+
+// the first item whose tag line contains key, NULL if there is none
+const SdfItem *FindSdfItem(const SdfMolecule *mol, const char *key);
+
+// the input conformation goes to ligs[0], the ENSEMBLE_COORDS farther than
+// MINLIGRMSD by ENSEMBLE_RMSD to ligs[1], ligs[2], ...
+// returns the number of conformations written, at most max_conf
+int ParseSdfLigand(const SdfMolecule *mol, Ligand0 *ligs, const int max_conf);
+
+#endif // SDF_READER_H
@@ -110,6 +110,18 @@
 
 #define MAX_DIST 1000.
 
+// records the host side ring between the launcher and the consumer holds
+#define RECORD_DRAIN_SZ 65536
+
+// expected fraction of accepted MC steps, sizes the default trajectory ring
+#define RECORD_ACCEPT_RATIO 0.5f
+
+// record batches queued for the output thread before the launcher blocks
+#define ASYNC_WRITER_DEPTH 4
+
+// relative energy spread of the simplex at which local refinement stops
+#define MIN_FTOL 1.0e-4f
+
 #define MINIMUM_CLUSTERS 4
 #define MAXIMUM_CLUSTERS 20
 
@@ -0,0 +1,49 @@
+#ifndef TEXT_SCAN_H
+#define TEXT_SCAN_H
+
+#include <cstddef>
+
+// text_scan.C
+// read only mapped input files, and scanning of lines, tokens and numbers
+// in place, for the loaders of load.C and sdf_reader.C
+
+struct MappedFile
+{
+  const char *data;
+  size_t size;
+};
+
+// false if the file cannot be opened
+bool MapFile(const char *path, MappedFile *file);
+
+void UnmapFile(MappedFile *file);
+
+// a span [begin, end) of the mapped text
+struct TextSpan
+{
+  const char *begin;
+  const char *end;
+};
+
+// the next line without its line break, false at the end of the text
+// p is moved past the line break
+bool NextLine(const char **p, const char *end, TextSpan *line);
+
+// the next whitespace separated token, false when none is left
+bool NextToken(const char **p, const char *end, TextSpan *tok);
+
+// columns [col, col + width) of a line, clipped to the line
+TextSpan Columns(const TextSpan &line, const int col, const int width);
+
+bool IsBlank(const TextSpan &span);
+
+// the span contains the NUL terminated key
+bool Contains(const TextSpan &span, const char *key);
+
+// leading and trailing whitespace is skipped, like atof and atoi, and
+// parsing stops at the first character that does not belong to the number
+// the float is the same as (float) atof of the text
+float ParseFloat(const TextSpan &span);
+int ParseInt(const TextSpan &span);
+
+#endif // TEXT_SCAN_H
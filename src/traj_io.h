@@ -0,0 +1,104 @@
+#ifndef TRAJ_IO_H
+#define TRAJ_IO_H
+
+#include <vector>
+#include <climits>
+
+#include "dock.h"
+#include "record_store.h"
+
+using namespace std;
+
+// traj_io.C
+// compact binary trajectory format
+//
+//   header   magic "GXTR", version, energy mode, translation range, block size
+//   blocks   magic "GXTB", record count, payload bytes, FNV-1a checksum,
+//            then the payload, column by column:
+//              replica ids   zigzag varint of the delta to the previous record
+//              step          zigzag varint of the delta to the previous record
+//              movematrix    16-bit fixed point, translation over
+//                            [-trans_range, trans_range], rotation over [-pi, pi]
+//              energies      e[MAXWEI], cms and rmsd, as set by the energy mode
+//   index    file offset, record count, first replica, first step, and the
+//            replica and step ranges per block
+//   footer   index offset, block count, magic "GXTI"
+//
+// all fields are little endian
+//
+// readers map the file, and decode only the blocks asked for
+
+// energy encodings
+#define TRAJ_ENERGY_RAW 0  // float32
+#define TRAJ_ENERGY_HALF 1 // float16, lossy
+#define TRAJ_ENERGY_XOR 2  // XOR with the previous record, lossless
+
+#define TRAJ_BLOCK_SZ 4096
+#define TRAJ_TRANS_RANGE 32.0f
+
+#define TRAJ_ALL_REPS -1
+
+struct TrajBlockIndex
+{
+  unsigned long long offset;
+  int n_records;
+  int first_rep;
+  int first_step;
+  int rep_min, rep_max;
+  int step_min, step_max;
+};
+
+struct TrajWriter;
+struct TrajReader;
+
+TrajWriter *OpenTrajWriter(const char *path, const int energy_mode);
+
+// records are buffered and written one block at a time
+void WriteTraj(TrajWriter *writer, const LigRecordSingleStep *steps, const int n);
+
+void WriteTraj(TrajWriter *writer, const RecordStore &store);
+
+// flush the last block, and write the index
+void CloseTrajWriter(TrajWriter *writer);
+
+TrajReader *OpenTrajReader(const char *path);
+
+int TrajEnergyMode(const TrajReader *reader);
+
+int CountTrajRecords(const TrajReader *reader);
+
+const vector<TrajBlockIndex> &TrajIndex(const TrajReader *reader);
+
+// decode one block, the records are appended to steps
+void ReadTrajBlock(TrajReader *reader, const int block,
+                   vector<LigRecordSingleStep> &steps);
+
+void ReadTraj(TrajReader *reader, vector<LigRecordSingleStep> &steps);
+
+void CloseTrajReader(TrajReader *reader);
+
+// records of one replica, or of all for TRAJ_ALL_REPS, with
+// step_begin <= step < step_end, in file order
+// a single block is decoded at a time, blocks outside the view are skipped
+struct TrajView
+{
+  TrajReader *reader;
+  int idx_rep;
+  int step_begin, step_end;
+  int block;                        // next block to look at
+  int pos;                          // next record of buf
+  vector<LigRecordSingleStep> buf;  // the decoded block
+};
+
+TrajView ViewTraj(TrajReader *reader, const int idx_rep,
+                  const int step_begin, const int step_end);
+
+TrajView ViewTrajReplica(TrajReader *reader, const int idx_rep);
+
+TrajView ViewTrajSteps(TrajReader *reader, const int step_begin, const int step_end);
+
+// the next record of the view, NULL past the last one
+// the record stays valid until the next call
+const LigRecordSingleStep *NextTrajRecord(TrajView *view);
+
+#endif // TRAJ_IO_H
@@ -1,22 +1,21 @@
 ################################################################################
-# use ./analysis to load the hdf5 record files and redirect the output to a csv format
-hd_paths=$(ls output_*/*.h5)
+# use ./analysis to read the trajectory files and redirect the output to a csv format
+hd_paths=$(ls output_*/*.gxt)
 rep=$1
 
 for hd_path in $hd_paths; do
-    echo -e "hdf file path:\t\t\t"$hd_path
+    echo -e "trajectory file path:\t\t\t"$hd_path
 
     dir_path=$(dirname $hd_path)
 
     hd_fn=${hd_path##*/}
 
-    base_name=${hd_fn%.h5}
+    base_name=${hd_fn%.gxt}
 
     csv_path=$dir_path/${base_name}_$rep.csv
     echo -e "csv output path:\t\t"$csv_path"\n"
 
-    # ./analysis -nl 20 -l 1 -p 2 -r 0 -e 1 $hd_path 
-    ./analysis -rep $rep -nl 4500 -l 1 -p 2 -e $hd_path > $csv_path
+    ./analysis -rep $rep -nl 4500 $hd_path > $csv_path
 done
 
 
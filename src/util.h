@@ -8,6 +8,8 @@
 #include <vector>
 #include "size.h"
 #include "dock.h"
+#include "record_store.h"
+#include "dist_mat.h"
 
 using namespace std;
 // util.C
@@ -35,6 +37,65 @@ void SetMcLog(McLog *);
 // move one ligand conf to a certain config based on the movematrix
 void PlaceLigand(Ligand *, const float *const);
 
+// contact matrix (lna x pnp) of the placed ligand and the score between two
+void InitContactMatrix(int *ref_matrix, Ligand *mylig,
+                       const Protein *const myprt,
+                       const EnePara *const enepara);
+float CalculateContactModeScore(int *ref1, int *ref2,
+                                const EnePara *const enepara, Ligand *mylig,
+                                const Protein *const myprt);
+
+// contact maps of a set of poses, one packed bitset per pose
+// bit l * pnp + p of a map is ref_matrix[l * pnp + p] of InitContactMatrix
+struct ContactMaps
+{
+  int n_bits;   // lna * pnp
+  int n_words;  // words per map
+  vector<unsigned long long> bits;  // n_words per pose
+  vector<int> n_contacts;           // set bits per pose
+};
+
+// places each pose once, the threads work on their own copies of the n_lig
+// ligand conformations
+void BuildContactMaps(const vector<LigRecordSingleStep> &steps, Ligand *lig,
+                      int n_lig, const Protein *const prt,
+                      const EnePara *const enepara, ContactMaps *maps);
+
+// CalculateContactModeScore of poses a and b, by popcount
+float ContactMapCms(const ContactMaps &maps, const int a, const int b);
+
+// rotation of PlaceLigand
+void RotationMatrix(const float *const movematrix, float rot[3][3]);
+
+// first and second moments of the coord_orig points of the n_lig ligand
+// conformations, the RMSD between two placed poses follows from their
+// movematrix alone, with no point placed
+struct PoseMoments
+{
+  int n_lig;
+  vector<double> sq;     // [n_lig] mean |x|^2
+  vector<double> mean;   // [n_lig][3] mean x
+  vector<double> cross;  // [n_lig][n_lig][3][3] mean x_p[i] * x_q[j]
+  vector<double> center; // [n_lig][3]
+};
+
+void BuildPoseMoments(const Ligand *lig, int n_lig, PoseMoments *moments);
+
+// a pose as placed by PlaceLigand, x -> rot x + trans
+struct PoseFrame
+{
+  float rot[3][3];
+  float trans[3];
+  int idx_lig;
+};
+
+void SetPoseFrame(const PoseMoments &moments, const LigRecordSingleStep &step,
+                  PoseFrame *frame);
+
+// RMSD over the lna points of the two placed ligands, in O(1)
+float PoseRmsd(const PoseMoments &moments, const PoseFrame &a,
+               const PoseFrame &b);
+
 // replace ligand coordinates
 list<string> replaceLigandCoords(LigandFile *, Ligand *);
 
@@ -107,6 +168,10 @@ void printHeader(const McPara *mcpara);
 vector<Medoid> clusterByKmeans(vector<LigRecordSingleStep> &steps,
                                int numClusters);
 
+// clustering the rows [row_begin, row_end) of the record store
+vector<Medoid> clusterByKmeans(const RecordStore &store, int row_begin,
+                               int row_end, int numClusters);
+
 vector<Medoid> clusterOneRepResults(vector<LigRecordSingleStep> &steps,
                                     string clustering_method, int n_lig,
                                     Ligand *lig, const Protein *const prt,
@@ -127,13 +192,29 @@ double **AllocateMatrix(int nrows, int ncolumns);
 
 void FreeMatrix(double **matrix);
 
-int CountValidRecords(
-    const map<int, vector<LigRecordSingleStep> > &multi_reps_records);
+// population control, pair the n_rep * prune_frac highest energy replicas
+// (dst) with the lowest energy ones (src), returns the number of pairs
+int PlanReplicaPruning(const float *etotal, const int n_rep,
+                       const float prune_frac, int *dst, int *src);
 
+// linkage 's' (single, method "c" of clusterOneRepResults) or 'a' (average
+// by the nearest neighbor chain of kgs.C, method "n")
 vector<Medoid> clusterCmsByAveLinkage(const vector<LigRecordSingleStep> &steps,
                                       int cluster_num, int n_lig, Ligand *lig,
                                       const Protein *const prt,
-                                      const EnePara *const enepara);
+                                      const EnePara *const enepara,
+                                      char linkage);
+
+// clusterCmsByAveLinkage on the leaders of the LSH buckets of contact_lsh.h
+vector<Medoid> clusterCmsByLsh(const vector<LigRecordSingleStep> &steps,
+                               int cluster_num, int n_lig, Ligand *lig,
+                               const Protein *const prt,
+                               const EnePara *const enepara);
+
+// average linkage on the pose RMSD of PoseRmsd
+vector<Medoid> clusterRmsdByAveLinkage(const vector<LigRecordSingleStep> &steps,
+                                       int cluster_num, int n_lig,
+                                       const Ligand *lig);
 
 void GenCmsSimiMat(const vector<LigRecordSingleStep> &steps, Ligand *lig,
                    const Protein *const prt, const EnePara *const enepara,
@@ -141,7 +222,7 @@ void GenCmsSimiMat(const vector<LigRecordSingleStep> &steps, Ligand *lig,
 
 void ParallelGenCmsSimiMat(const vector<LigRecordSingleStep> &steps,
                            Ligand *lig, int n_lig, const Protein *const prt,
-                           const EnePara *const enepara, double **dis_mat);
+                           const EnePara *const enepara, DistMat *dis_mat);
 
 void FreeSquareMatrix(double **mat, int tot);
 
@@ -0,0 +1,26 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+// work_pool.C
+// runs independent tasks of uneven cost on a pool of threads
+//
+// the tasks are sorted by decreasing cost and dealt round robin to one deque
+// per thread, a thread takes the largest task left at the front of its own
+// deque, and once it is empty steals the smallest from the back of another
+// one, the large tasks start first and the small ones fill the gaps
+//
+// each pool thread runs its OpenMP regions on one thread, the pool already
+// holds the cores
+
+// run fn(task) for task in [0, cost.size()), on n_threads threads, all the
+// cores for n_threads <= 0
+// returns the number of tasks stolen
+int RunTasksLargestFirst(const vector<long> &cost, const int n_threads,
+                         const function<void(int)> &fn);
+
+#endif // WORK_POOL_H